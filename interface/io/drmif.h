@@ -35,6 +35,13 @@
  * notification can be made conditional on req_event (i.e., the generic
  * hold-off mechanism provided by the ring macros). Backends must set
  * req_event appropriately (e.g., using RING_FINAL_CHECK_FOR_REQUESTS()).
+ * A backend may keep polling the control ring for new requests for a while
+ * after it has processed the last one, before it re-arms req_event with
+ * RING_FINAL_CHECK_FOR_REQUESTS() and waits for the event channel: the
+ * frontend does not send notifications while req_event is not re-armed.
+ * Requests must be processed in the same way in both cases.
+ * If ctrl-poll is negotiated the frontend doesn't use req_event at all,
+ * but notifies the backend only when its poller is idle, see ctrl-poll.
  *
  * Back->front notifications: When enqueuing a new response, sending a
  * notification can be made conditional on rsp_event (i.e., the generic
@@ -81,6 +88,112 @@
  *
  *      Zero based contiguous index of the connector within the card.
  *
+ *--------------------------------- Features ---------------------------------
+ *
+ * feature-fb-handle
+ *      Values:         <bool>
+ *
+ *      If set to 1 the backend returns a non-zero fb_handle in the response
+ *      to XENDRM_OP_FB_CREATE, which the frontend may pass in the requests
+ *      referring to that framebuffer instead of relying on fb_cookie lookup
+ *      only. If not set or set to 0 the frontend must put
+ *      XENDRM_FB_HANDLE_INVALID into all fb_handle fields.
+ *
+ * feature-timed-flip
+ *      Values:         <bool>
+ *
+ *      If set to 1 the backend honors target_vblank and present_time of
+ *      XENDRM_OP_PG_FLIP requests and reports vblank_seq and timestamp in
+ *      XENDRM_EVT_PG_FLIP events.
+ *
+ * feature-ctrl-poll
+ *      Values:         <bool>
+ *
+ *      If set to 1 the backend can run a dedicated poller for the control
+ *      rings, so the frontend may request ctrl-poll.
+ *
+ * feature-dumb-no-clear
+ *      Values:         <bool>
+ *
+ *      If set to 1 the backend honors XENDRM_DUMB_FLAG_NO_CLEAR.
+ *
+ * feature-stats
+ *      Values:         <bool>
+ *
+ *      If set to 1 the backend fills a statistics page the frontend may
+ *      grant with stats-page-ref.
+ *
+ * feature-capture
+ *      Values:         <bool>
+ *
+ *      If set to 1 the backend supports XENDRM_OP_CAPTURE.
+ *
+ * max-flip-queue-depth
+ *      Values:         <uint>
+ *
+ *      The maximum number of page flips the backend can hold queued per CRTC,
+ *      including the one being displayed next. If not set, 1 is assumed.
+ *
+ * feature-scaling
+ *      Values:         <bool>
+ *
+ *      If set to 1 the backend supports all scaling_mode values of
+ *      XENDRM_OP_SET_CONFIG.
+ *
+ * feature-transport-blob
+ *      Values:         <bool>
+ *
+ *      If set to 1 the frontend may publish the transport parameters of all
+ *      connectors in a single transport node instead of the per connector
+ *      nodes.
+ *
+ * feature-resume
+ *      Values:         <bool>
+ *
+ *      If set to 1 the backend can resume a session after it has restarted,
+ *      see session-id.
+ *
+ * feature-prio
+ *      Values:         <bool>
+ *
+ *      If set to 1 the backend honors XENDRM_REQ_FLAG_PRIO_HIGH.
+ *
+ * feature-deferred-destroy
+ *      Values:         <bool>
+ *
+ *      If set to 1 the backend supports XENDRM_OP_BULK_DESTROY and retires
+ *      destroyed objects in the background, see Deferred destruction below.
+ *
+ * max-protocol-version
+ *      Values:         <uint>
+ *
+ *      The highest protocol version the backend supports, see Protocol
+ *      version 2 below. If not set, 1 is assumed.
+ *
+ * pixel-formats
+ *      Values:         <uint>[,<uint>...]
+ *
+ *      DRM fourcc codes of the pixel formats the backend can scan out
+ *      without conversion, separated by XENDRM_LIST_SEPARATOR, the most
+ *      preferred first. For example,
+ *      vdrm/0/pixel-formats = "875713112,875713089"
+ *      Framebuffers of other formats may still be accepted by
+ *      XENDRM_OP_FB_CREATE, but then the backend has to convert every frame
+ *      displayed, so the frontend should use one of these formats if it can.
+ *      If not set, no assumption on the formats can be made.
+ *
+ *------------------------------- Session state -------------------------------
+ *
+ * session-resumed
+ *      Values:         <bool>
+ *
+ *      Written by the backend before it enters XenbusStateConnected.
+ *      1 if all dumb buffers and framebuffers of the frontend's session-id
+ *      were restored, so their dumb_cookie/fb_cookie values remain valid,
+ *      0 or not set if the frontend has to create them anew. fb_handle
+ *      values returned before the restart are never valid after it, see
+ *      Backend restart with session resume.
+ *
  *----------------------------- Connector settings -----------------------------
  * resolution
  *      Values:         <[width]x[height]>
@@ -89,6 +202,19 @@
  *      XENDRM_RESOLUTION_SEPARATOR. For example,
  *      vdrm/0/connector/0/resolution = "800x600"
  *
+ * connectors
+ *      Values:         <[width]x[height]>[,<[width]x[height]>...]
+ *
+ *      Optional compact form of the connector settings of the whole device,
+ *      so they can be read at once: resolutions of all connectors in conn_id
+ *      order, separated by XENDRM_LIST_SEPARATOR. It is written in addition
+ *      to the per connector resolution nodes, which the tool stack must
+ *      always write, as existing readers only know those. Readers aware of
+ *      this node may read it first and fall back to the per connector nodes
+ *      if it is not present. Both must describe the same connectors.
+ *      For example,
+ *      vdrm/0/connectors = "800x600,1920x1080"
+ *
  *
  *****************************************************************************
  *                            Frontend XenBus Nodes
@@ -121,6 +247,95 @@
  *
  *      The Xen grant reference granting permission for the backend to map
  *      a sole page in a single page sized connector's event ring buffer.
+ *
+ * protocol-version
+ *      Values:         <uint>
+ *
+ *      Per device and optional. The version of the packet layouts used on
+ *      all control and event rings of the device, not higher than
+ *      max-protocol-version of the backend. If not set, 1 is assumed.
+ *
+ * session-id
+ *      Values:         <uint>
+ *
+ *      Per device and optional. A random non-zero value identifying the set
+ *      of dumb buffers and framebuffers the frontend has created, kept the
+ *      same while the frontend driver instance exists. If the backend sets
+ *      feature-resume, the frontend keeps its buffers and grants when
+ *      the backend goes away and publishes the same session-id when
+ *      reconnecting, so the backend can re-attach to them, see
+ *      session-resumed.
+ *
+ * transport
+ *      Values:         <ctrl-ring-ref>:<ctrl-channel>:<event-ring-ref>:
+ *                      <event-channel>[,...]
+ *
+ *      Per device and only if the backend sets feature-transport-blob.
+ *      The four transport parameters above for every connector in conn_id
+ *      order, separated by XENDRM_FIELD_SEPARATOR, connectors separated by
+ *      XENDRM_LIST_SEPARATOR. If published, the per connector transport
+ *      nodes are not, so the backend reads all of them with a single
+ *      XenStore access. For example,
+ *      vdrm/0/transport = "8:15:9:16,10:17:11:18"
+ *
+ * ctrl-poll
+ *      Values:         <bool>
+ *
+ *      Per device and optional. If set to 1 and the backend sets
+ *      feature-ctrl-poll, the control rings of this device are serviced by
+ *      a backend poller watching req_prod and the frontend sends control
+ *      event channel notifications only while that poller is idle. The state
+ *      of the poller is kept in the octet of the shared ring page right after
+ *      rsp_event, see XENDRM_CTRL_POLL_STATE(), which is unused by the
+ *      generic ring macros:
+ *      XENDRM_CTRL_POLL_IDLE - the poller sleeps on the event channel
+ *        and must be notified of new requests. This is the initial state.
+ *      XENDRM_CTRL_POLL_ACTIVE - the poller is running and will see new
+ *        requests without a notification.
+ *      After pushing requests the frontend issues a full memory barrier and
+ *      notifies the backend only if the state is XENDRM_CTRL_POLL_IDLE.
+ *      Before going to sleep the poller sets the state to
+ *      XENDRM_CTRL_POLL_IDLE, issues a full memory barrier and checks for
+ *      new requests once more; it sets XENDRM_CTRL_POLL_ACTIVE again when it
+ *      resumes polling.
+ *
+ *--------------------------------- Page flip ---------------------------------
+ *
+ * These are per device and optional.
+ *
+ * flip-queue-depth
+ *      Values:         <uint>
+ *
+ *      The number of XENDRM_OP_PG_FLIP requests the frontend may have
+ *      in flight per CRTC, i.e. sent, but not yet completed with
+ *      XENDRM_EVT_PG_FLIP. Must not exceed max-flip-queue-depth of the
+ *      backend. If not set, 1 is assumed: the frontend waits for
+ *      XENDRM_EVT_PG_FLIP before sending the next page flip for that CRTC.
+ *
+ * flip-mode
+ *      Values:         "fifo", "mailbox"
+ *
+ *      How the backend handles queued page flips of a CRTC if
+ *      flip-queue-depth is greater than 1. If not set, "fifo" is assumed.
+ *      XENDRM_FLIP_MODE_FIFO - every queued framebuffer is displayed for
+ *        at least one vertical blank, in order of requests.
+ *      XENDRM_FLIP_MODE_MAILBOX - when a vertical blank comes only the latest
+ *        queued framebuffer is displayed: all other queued framebuffers are
+ *        dropped and reported with XENDRM_EVT_PG_FLIP having
+ *        XENDRM_PG_FLIP_EVT_FLAG_SUPERSEDED set.
+ *
+ *-------------------------------- Statistics ---------------------------------
+ *
+ * This is per device and optional.
+ *
+ * stats-page-ref
+ *      Values:         <uint>
+ *
+ *      The Xen grant reference granting permission for the backend to map
+ *      a sole page the backend fills with its statistics for this device,
+ *      see struct xendrm_stats_page. Only published if the backend sets
+ *      feature-stats. The page must be zeroed by the frontend, its version
+ *      field stays 0 until the backend has mapped it.
  */
 
 /*
@@ -180,6 +395,104 @@
  *              V
  * XenbusStateClosed
  *
+ *****************************************************************************
+ *                      Backend restart with session resume                  *
+ *****************************************************************************
+ *
+ * Only if the backend set feature-resume and the frontend published
+ * session-id for the connection being lost.
+ *
+ * Front                                Back
+ * =================================    =====================================
+ * XenbusStateConnected                 XenbusStateConnected
+ *                                       o Keep dumb_cookie/fb_cookie to
+ *                                         grant reference mappings of the
+ *                                         session in a persistent store,
+ *                                         e.g. a memory mapped state file.
+ *                                       o Write every dumb buffer and
+ *                                         framebuffer creation/destruction
+ *                                         to the store before posting its
+ *                                         response.
+ *                                                      |
+ *                                                      | backend restarts
+ *                                                      V
+ *                                      XenbusStateClosed
+ *
+ * o Keep the virtual DRM device,
+ *   dumb buffers, framebuffers and
+ *   their grants.
+ * o Remove event channels
+ *              |
+ *              |
+ *              V
+ * XenbusStateInitialising
+ *                                      XenbusStateInitialising
+ *                                       o Load the persistent store.
+ *                                                      |
+ *                                                      |
+ *                                                      V
+ *                                      XenbusStateInitWait
+ *
+ * o Re-initialize both rings with
+ *   SHARED_RING_INIT and
+ *   FRONT_RING_INIT, allocate and
+ *   initialize event channels
+ * o Publish transport parameters
+ *   with the same session-id.
+ *              |
+ *              |
+ *              V
+ * XenbusStateInitialised
+ *
+ *                                       o If session-id matches the stored
+ *                                         one, re-map the grants of all
+ *                                         stored buffers and publish
+ *                                         session-resumed = 1, otherwise
+ *                                         drop the store and publish
+ *                                         session-resumed = 0.
+ *                                       o Attach to the rings afresh with
+ *                                         BACK_RING_INIT, nothing is
+ *                                         consumed from the old ones.
+ *                                       o Connect to the event channels.
+ *                                                      |
+ *                                                      |
+ *                                                      V
+ *                                      XenbusStateConnected
+ *
+ *  o If session-resumed is 1 keep
+ *  using existing cookies and reset
+ *  all fb_handle values to
+ *  XENDRM_FB_HANDLE_INVALID,
+ *  otherwise re-create all dumb
+ *  buffers and framebuffers.
+ *  o Re-send requests which got no
+ *  response, see below.
+ *              |
+ *              |
+ *              V
+ * XenbusStateConnected
+ *
+ * Scanout configuration and queued page flips are not resumed: the frontend
+ * sends XENDRM_OP_SET_CONFIG again and treats page flips in flight at the
+ * time the connection was lost as completed. Framebuffer handles are not
+ * resumed either: the restarted backend has a new handle table, so the
+ * frontend uses XENDRM_FB_HANDLE_INVALID for every resumed framebuffer.
+ *
+ * Requests other than page flips which were sent, but not answered, when
+ * the connection was lost may or may not have been executed. As the
+ * backend writes every object change to its store before posting the
+ * response, the store is never behind the responses the frontend has
+ * seen. If session-resumed is 1 the frontend re-sends all such requests
+ * in their original order, except XENDRM_OP_SET_CONFIG which it sends
+ * anew anyway. Once it has published session-resumed = 1, the backend
+ * treats a repeated XENDRM_OP_DUMB_CREATE or XENDRM_OP_FB_CREATE of a cookie
+ * it already has with the same parameters, and a XENDRM_OP_DUMB_DESTROY,
+ * XENDRM_OP_FB_DESTROY or XENDRM_OP_BULK_DESTROY of cookies none of which it
+ * has, as success, so a request executed before the restart completes the
+ * same way again.
+ * If session-resumed is 0 there is nothing to re-send: all objects are
+ * re-created from scratch.
+ *
  */
 
 /*
@@ -191,11 +504,57 @@
 #define XENDRM_OP_FB_DESTROY            3
 #define XENDRM_OP_SET_CONFIG            4
 #define XENDRM_OP_PG_FLIP               5
+#define XENDRM_OP_CAPTURE               6
+#define XENDRM_OP_BULK_DESTROY          7
 
 /*
  * EVENT CODES.
  */
 #define XENDRM_EVT_PG_FLIP              0
+#define XENDRM_EVT_CAPTURE              1
+
+/*
+ * REQUEST FLAGS.
+ */
+ /* Latency critical request, processed ahead of normal priority ones. */
+#define XENDRM_REQ_FLAG_PRIO_HIGH            (1 << 0)
+ /* Normal priority requests can be overtaken by this many at most. */
+#define XENDRM_PRIO_MAX_BYPASS               16
+
+/*
+ * PAGE FLIP REQUEST FLAGS.
+ */
+ /* Do not flip before vertical blank target_vblank. */
+#define XENDRM_PG_FLIP_FLAG_TARGET_VBLANK    (1 << 0)
+ /* Do not flip before Xen system time present_time. */
+#define XENDRM_PG_FLIP_FLAG_PRESENT_TIME     (1 << 1)
+
+/*
+ * DUMB CREATION FLAGS.
+ */
+ /* Contents are undefined until the first flip, do not clear the buffer. */
+#define XENDRM_DUMB_FLAG_NO_CLEAR            (1 << 0)
+
+/*
+ * SET CONFIG SCALING MODES.
+ */
+#define XENDRM_SCALING_DEFAULT               0
+#define XENDRM_SCALING_NONE                  1
+#define XENDRM_SCALING_NEAREST               2
+#define XENDRM_SCALING_BILINEAR              3
+#define XENDRM_SCALING_INTEGER               4
+
+/*
+ * CAPTURE REQUEST FLAGS.
+ */
+ /* Only copy regions changed since the previous capture of the CRTC. */
+#define XENDRM_CAPTURE_FLAG_INCREMENTAL      (1 << 0)
+
+/*
+ * PAGE FLIP EVENT FLAGS.
+ */
+ /* Framebuffer was replaced by a newer page flip and was not displayed. */
+#define XENDRM_PG_FLIP_EVT_FLAG_SUPERSEDED   (1 << 0)
 
 /*
  * XENSTORE FIELD AND PATH NAME STRINGS, HELPERS.
@@ -203,12 +562,49 @@
 #define XENDRM_DRIVER_NAME                   "vdrm"
 
 #define XENDRM_RESOLUTION_SEPARATOR          "x"
+#define XENDRM_LIST_SEPARATOR                ","
+#define XENDRM_FIELD_SEPARATOR               ":"
 /* Field names */
 #define XENDRM_FIELD_CTRL_RING_REF           "ctrl-ring-ref"
 #define XENDRM_FIELD_CTRL_CHANNEL            "ctrl-channel"
 #define XENDRM_FIELD_EVT_RING_REF            "event-ring-ref"
 #define XENDRM_FIELD_EVT_CHANNEL             "event-channel"
 #define XENDRM_FIELD_RESOLUTION              "resolution"
+#define XENDRM_FIELD_FEATURE_FB_HANDLE       "feature-fb-handle"
+#define XENDRM_FIELD_STATS_PAGE_REF          "stats-page-ref"
+#define XENDRM_FIELD_FEATURE_STATS           "feature-stats"
+#define XENDRM_FIELD_FEATURE_TIMED_FLIP      "feature-timed-flip"
+#define XENDRM_FIELD_MAX_FLIP_QUEUE_DEPTH    "max-flip-queue-depth"
+#define XENDRM_FIELD_FEATURE_CAPTURE         "feature-capture"
+#define XENDRM_FIELD_FEATURE_DUMB_NO_CLEAR   "feature-dumb-no-clear"
+#define XENDRM_FIELD_PIXEL_FORMATS           "pixel-formats"
+#define XENDRM_FIELD_FEATURE_SCALING         "feature-scaling"
+#define XENDRM_FIELD_CONNECTORS              "connectors"
+#define XENDRM_FIELD_FEATURE_TRANSPORT_BLOB  "feature-transport-blob"
+#define XENDRM_FIELD_TRANSPORT               "transport"
+#define XENDRM_FIELD_FEATURE_RESUME          "feature-resume"
+#define XENDRM_FIELD_SESSION_ID              "session-id"
+#define XENDRM_FIELD_SESSION_RESUMED         "session-resumed"
+#define XENDRM_FIELD_FEATURE_PRIO            "feature-prio"
+#define XENDRM_FIELD_FEATURE_DEFERRED_DESTROY "feature-deferred-destroy"
+#define XENDRM_FIELD_MAX_PROTOCOL_VERSION    "max-protocol-version"
+#define XENDRM_FIELD_PROTOCOL_VERSION        "protocol-version"
+#define XENDRM_FIELD_FEATURE_CTRL_POLL       "feature-ctrl-poll"
+#define XENDRM_FIELD_CTRL_POLL               "ctrl-poll"
+#define XENDRM_FIELD_FLIP_QUEUE_DEPTH        "flip-queue-depth"
+#define XENDRM_FIELD_FLIP_MODE               "flip-mode"
+
+/* Page flip modes */
+#define XENDRM_FLIP_MODE_FIFO                "fifo"
+#define XENDRM_FLIP_MODE_MAILBOX             "mailbox"
+
+/* Control ring poller states */
+#define XENDRM_CTRL_POLL_IDLE                0
+#define XENDRM_CTRL_POLL_ACTIVE              1
+
+/* Protocol versions */
+#define XENDRM_PROTOCOL_VERSION_1            1
+#define XENDRM_PROTOCOL_VERSION_2            2
 
 /*
  * STATUS RETURN CODES.
@@ -218,6 +614,12 @@
  /* Operation completed successfully. */
 #define XENDRM_RSP_OKAY                  0
 
+/*
+ * FRAMEBUFFER HANDLES.
+ */
+ /* No handle: the backend must resolve the framebuffer by its fb_cookie. */
+#define XENDRM_FB_HANDLE_INVALID         0
+
 /* Path entries */
 #define XENDRM_PATH_CONNECTOR                "connector"
 
@@ -234,11 +636,34 @@
  *
  * All request packets have the same length (64 octets)
  *
+ * req_flags - uint8_t, XENDRM_REQ_FLAG_XXX, common to all requests, see
+ *   Flags below. Not to be confused with the operation specific flags
+ *   field some requests carry.
+ *
+ * Flags: the same rule applies to req_flags and to all flags fields of
+ *   requests. The frontend may only set a flag if the backend sets the
+ *   feature node which defines it, and must leave all other bits 0. The
+ *   backend must ignore bits it does not know. The flags are defined by:
+ *   XENDRM_REQ_FLAG_PRIO_HIGH - feature-prio
+ *   XENDRM_DUMB_FLAG_NO_CLEAR - feature-dumb-no-clear
+ *   XENDRM_PG_FLIP_FLAG_XXX - feature-timed-flip
+ *   XENDRM_CAPTURE_FLAG_XXX - feature-capture
+ *
+ * Requests with XENDRM_REQ_FLAG_PRIO_HIGH, e.g. page flips, are
+ *   latency critical: the backend processes them before any other pending
+ *   requests of the ring, so they don't wait behind e.g. creation of big
+ *   dumb buffers, and their responses may come out of request order.
+ *   To keep the rest moving the backend must not let more than
+ *   XENDRM_PRIO_MAX_BYPASS high priority requests overtake a pending normal
+ *   priority one. The frontend must not send a high priority request which
+ *   depends on a normal priority request not yet responded to, e.g.
+ *   a page flip to a framebuffer still being created.
+ *
  *
  * Request dumb creation - request creation of a DRM dumb buffer.
  *          0                 1                  2                3        octet
  * +-----------------+-----------------+-----------------+-----------------+
- * |                 id                |    operation    |     reserved    |
+ * |                 id                |    operation    |    req_flags    |
  * +-----------------+-----------------+-----------------+-----------------+
  * |                         dumb_cookie low 32-bit                        |
  * +-----------------+-----------------+-----------------+-----------------+
@@ -252,6 +677,8 @@
  * +-----------------+-----------------+-----------------+-----------------+
  * |                         gref_directory_start                          |
  * +-----------------+-----------------+-----------------+-----------------+
+ * |                                 flags                                 |
+ * +-----------------+-----------------+-----------------+-----------------+
  * |                               reserved                                |
  * +-----------------+-----------------+-----------------+-----------------+
  * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
@@ -271,6 +698,12 @@
  *   buffer size exceeds what can be addressed by this single page, then
  *   reference to the next page must be supplied (gref_dir_next_page below
  *   is not NULL)
+ * flags - uint32_t, XENDRM_DUMB_FLAG_XXX, see Flags above
+ *   XENDRM_DUMB_FLAG_NO_CLEAR - the contents of the buffer are undefined
+ *     until it is displayed for the first time, as the frontend will
+ *     overwrite them anyway: the backend does not clear or otherwise
+ *     initialize its local counterpart of the buffer and does not scan it out
+ *     before the first page flip or configuration set to a framebuffer of it.
  *
  * Shared page for XENDRM_OP_DUMB_CREATE buffer descriptor (gref_directory in
  *   the request) employs a list of pages, describing all pages of the shared
@@ -296,11 +729,23 @@
  * gref[i] - grant_ref_t, reference to a shared page of the dumb buffer
  *   allocated at XENDRM_OP_DUMB_CREATE
  *
+ * The dumb buffer is laid out line by line with the pitch of
+ *   (width * bpp + 7) / 8 octets, so it occupies
+ *   XENDRM_DUMB_NUM_GREFS(width, height, bpp) pages. Every page of the
+ *   directory, except the last one, must be full, i.e. contain exactly
+ *   XENDRM_NUM_GREFS_PER_PAGE grefs, and the last page must hold the rest,
+ *   with its gref_dir_next_page set to 0. This allows the backend to
+ *   validate num_grefs of each directory page and start mapping the grefs it
+ *   lists as soon as the page is read, without walking the whole directory
+ *   first.
+ *   If any directory page is malformed the backend unmaps whatever was
+ *   already mapped for this buffer and responds with XENDRM_RSP_ERROR.
+ *
  *
  * Request dumb destruction - destroy a previously allocated dumb buffer:
  *          0                 1                  2                3        octet
  * +-----------------+-----------------+-----------------+-----------------+
- * |                 id                |    operation    |     reserved    |
+ * |                 id                |    operation    |    req_flags    |
  * +-----------------+-----------------+-----------------+-----------------+
  * |                         dumb_cookie low 32-bit                        |
  * +-----------------+-----------------+-----------------+-----------------+
@@ -322,7 +767,7 @@
  * Request framebuffer creation - request creation of a DRM framebuffer.
  *          0                 1                  2                3        octet
  * +-----------------+-----------------+-----------------+-----------------+
- * |                 id                |    operation    |     reserved    |
+ * |                 id                |    operation    |    req_flags    |
  * +-----------------+-----------------+-----------------+-----------------+
  * |                         dumb_cookie low 32-bit                        |
  * +-----------------+-----------------+-----------------+-----------------+
@@ -353,19 +798,22 @@
  *   to map remote framebuffer to local in requests
  * width - uint32_t, width in pixels
  * height - uint32_t, height in pixels
- * pixel_format - uint32_t, pixel format of the framebuffer
+ * pixel_format - uint32_t, pixel format of the framebuffer, DRM fourcc code,
+ *   preferably one of pixel-formats of the backend
  *
  *
  * Request framebuffer destruction - destroy a previously
  *   allocated framebuffer buffer:
  *          0                 1                  2                3        octet
  * +-----------------+-----------------+-----------------+-----------------+
- * |                 id                |    operation    |     reserved    |
+ * |                 id                |    operation    |    req_flags    |
  * +-----------------+-----------------+-----------------+-----------------+
  * |                          fb_cookie low 32-bit                         |
  * +-----------------+-----------------+-----------------+-----------------+
  * |                          fb_cookie high 32-bit                        |
  * +-----------------+-----------------+-----------------+-----------------+
+ * |                               fb_handle                               |
+ * +-----------------+-----------------+-----------------+-----------------+
  * |                               reserved                                |
  * +-----------------+-----------------+-----------------+-----------------+
  * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
@@ -375,15 +823,17 @@
  *
  * id - uint16_t, private guest value, echoed in response
  * operation - uint8_t, XENDRM_OP_FB_DESTROY
- * dumb_cookie - uint64_t, unique to guest domain value used by the backend
- *   to map remote dumb to local in requests
+ * fb_cookie - uint64_t, unique to guest domain value used by the backend
+ *   to map remote framebuffer to local in requests
+ * fb_handle - uint32_t, handle returned by the backend in response to
+ *   XENDRM_OP_FB_CREATE or XENDRM_FB_HANDLE_INVALID, see below
  *
  *
  * Request configuration set/reset - request to set or reset
  *   the configuration/mode on CRTC:
  *          0                 1                  2                3        octet
  * +-----------------+-----------------+-----------------+-----------------+
- * |                 id                |    operation    |     reserved    |
+ * |                 id                |    operation    |    req_flags    |
  * +-----------------+-----------------+-----------------+-----------------+
  * |                          fb_cookie low 32-bit                         |
  * +-----------------+-----------------+-----------------+-----------------+
@@ -399,6 +849,10 @@
  * +-----------------+-----------------+-----------------+-----------------+
  * |                                  bpp                                  |
  * +-----------------+-----------------+-----------------+-----------------+
+ * |                               fb_handle                               |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                              scaling_mode                             |
+ * +-----------------+-----------------+-----------------+-----------------+
  * |                               reserved                                |
  * +-----------------+-----------------+-----------------+-----------------+
  * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
@@ -415,13 +869,32 @@
  * width - uint32_t, width in pixels
  * height - uint32_t, height in pixels
  * bpp - uint32_t, bits per pixel
+ * fb_handle - uint32_t, handle returned by the backend in response to
+ *   XENDRM_OP_FB_CREATE or XENDRM_FB_HANDLE_INVALID, see below
+ * scaling_mode - uint32_t, XENDRM_SCALING_XXX, how the backend fits
+ *   width x height into the connector's resolution if they differ. Must be
+ *   XENDRM_SCALING_DEFAULT if the backend doesn't set feature-scaling.
+ *   XENDRM_SCALING_DEFAULT - backend specific.
+ *   XENDRM_SCALING_NONE - no scaling, the image is centered on the
+ *     connector and cropped if it doesn't fit.
+ *   XENDRM_SCALING_NEAREST - stretched to the connector's resolution with
+ *     nearest neighbour sampling.
+ *   XENDRM_SCALING_BILINEAR - stretched to the connector's resolution with
+ *     bilinear filtering.
+ *   XENDRM_SCALING_INTEGER - scaled by the biggest integer factor, the same
+ *     for both axes, at which the image still fits the connector, and
+ *     centered. Each pixel is replicated, e.g. 1280x720 is shown at 3x on
+ *     a 3840x2160 connector.
+ *   The backend responds with XENDRM_RSP_ERROR if it cannot scale as
+ *   requested, e.g. if the image doesn't fit the connector at factor 1 for
+ *   XENDRM_SCALING_INTEGER.
  *
  *
  * Request page flip - request to flip a page identified by the framebuffer
  *   cookie:
  *          0                 1                  2                3        octet
  * +-----------------+-----------------+-----------------+-----------------+
- * |                 id                |    operation    |     reserved    |
+ * |                 id                |    operation    |    req_flags    |
  * +-----------------+-----------------+-----------------+-----------------+
  * |                                 crtc_idx                              |
  * +-----------------+-----------------+-----------------+-----------------+
@@ -429,6 +902,18 @@
  * +-----------------+-----------------+-----------------+-----------------+
  * |                          fb_cookie high 32-bit                        |
  * +-----------------+-----------------+-----------------+-----------------+
+ * |                               fb_handle                               |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                                 flags                                 |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                        target_vblank low 32-bit                       |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                        target_vblank high 32-bit                      |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                        present_time low 32-bit                        |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                        present_time high 32-bit                       |
+ * +-----------------+-----------------+-----------------+-----------------+
  * |                               reserved                                |
  * +-----------------+-----------------+-----------------+-----------------+
  * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
@@ -441,6 +926,198 @@
  * crtc_idx - uint32_t, private guest value, echoed in response by the back
  * fb_cookie - uint64_t, unique to guest domain value used by the backend
  *   to map remote framebuffer to local in requests
+ * fb_handle - uint32_t, handle returned by the backend in response to
+ *   XENDRM_OP_FB_CREATE or XENDRM_FB_HANDLE_INVALID, see below
+ * flags - uint32_t, XENDRM_PG_FLIP_FLAG_XXX, see Flags above
+ * target_vblank - uint64_t, if XENDRM_PG_FLIP_FLAG_TARGET_VBLANK is set,
+ *   the vertical blank sequence number of the CRTC, as reported in
+ *   XENDRM_EVT_PG_FLIP, at which the framebuffer is to be displayed
+ * present_time - uint64_t, if XENDRM_PG_FLIP_FLAG_PRESENT_TIME is set,
+ *   Xen system time in nanoseconds before which the framebuffer must not
+ *   be displayed
+ *
+ * If both flags are set the page flip is done at the first vertical blank
+ *   satisfying both conditions. A page flip whose target is already in
+ *   the past is done at the next vertical blank. The backend holds a timed
+ *   page flip in the CRTC's flip queue until it is due, so it counts in
+ *   flip-queue-depth, and page flips of a CRTC are still done in order of
+ *   requests. In mailbox flip-mode a queued page flip is only superseded by
+ *   a newer one which is due at the same vertical blank.
+ *
+ *
+ * Request capture - request to copy what is currently shown on the connector
+ *   into a dumb buffer:
+ *          0                 1                  2                3        octet
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                 id                |    operation    |    req_flags    |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                                 crtc_idx                              |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                         dumb_cookie low 32-bit                        |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                         dumb_cookie high 32-bit                       |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                                 flags                                 |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                              pixel_format                             |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ *
+ * id - uint16_t, private guest value, echoed in response
+ * operation - uint8_t, XENDRM_OP_CAPTURE
+ * crtc_idx - uint32_t, index of the CRTC to capture
+ * dumb_cookie - uint64_t, cookie of a dumb buffer previously created with
+ *   XENDRM_OP_DUMB_CREATE to copy the output to. Its width and height must
+ *   be those of the connector's resolution.
+ * flags - uint32_t, XENDRM_CAPTURE_FLAG_XXX, see Flags above
+ * pixel_format - uint32_t, pixel format of the captured data, DRM fourcc
+ *   code, preferably one of pixel-formats of the backend. Its bits per pixel
+ *   must match bpp of the dumb buffer.
+ *
+ * The backend captures its composed output for the connector: the
+ *   framebuffer set on the CRTC, scaled according to its scaling_mode and
+ *   composed with anything else the backend shows on the connector, at the
+ *   connector's resolution. Areas not covered by the framebuffer, e.g. the
+ *   borders left by XENDRM_SCALING_NONE, are black, and so is the whole
+ *   output if the CRTC has no configuration set or it was reset. The data
+ *   is converted to pixel_format and written with the pitch defined for
+ *   dumb buffers. If the dumb buffer doesn't match the connector's
+ *   resolution or the backend cannot convert to pixel_format, the backend
+ *   responds with XENDRM_RSP_ERROR and does not touch the dumb buffer. The
+ *   first incremental capture after such an error, or after a new
+ *   configuration is set on the CRTC, copies everything.
+ *
+ * Without XENDRM_CAPTURE_FLAG_INCREMENTAL the whole output is copied.
+ *   With the flag only the regions changed since the previous capture of
+ *   this CRTC into the same dumb buffer are copied, the first such capture
+ *   copies everything. The changed regions are reported with
+ *   XENDRM_EVT_CAPTURE events, sent before the response, and their total
+ *   number is returned in the response. The backend may report a region
+ *   bigger than what has actually changed or merge regions to fit them into
+ *   events.
+ *
+ *
+ * Request bulk destruction - destroy a number of previously allocated
+ *   framebuffers and dumb buffers at once:
+ *          0                 1                  2                3        octet
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                 id                |    operation    |    req_flags    |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |           num_fb_cookies          |          num_dumb_cookies         |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                          cookie[0] low 32-bit                         |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                          cookie[0] high 32-bit                        |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                          cookie[5] low 32-bit                         |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                          cookie[5] high 32-bit                        |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ *
+ * id - uint16_t, private guest value, echoed in response
+ * operation - uint8_t, XENDRM_OP_BULK_DESTROY
+ * num_fb_cookies - uint16_t, number of fb_cookie values at the beginning
+ *   of cookie[]
+ * num_dumb_cookies - uint16_t, number of dumb_cookie values following them,
+ *   num_fb_cookies + num_dumb_cookies must not exceed
+ *   XENDRM_BULK_DESTROY_MAX_COOKIES
+ * cookie[i] - uint64_t, cookies of the framebuffers, then of the dumb
+ *   buffers to destroy, in this order
+ *
+ * The backend either destroys all the objects listed or, if any of the
+ *   cookies is unknown, none of them and responds with XENDRM_RSP_ERROR.
+ *   After a session resume all of the cookies being unknown is not an
+ *   error, see Backend restart with session resume.
+ *
+ * Deferred destruction: if the backend sets feature-deferred-destroy it
+ *   responds to XENDRM_OP_FB_DESTROY, XENDRM_OP_DUMB_DESTROY and
+ *   XENDRM_OP_BULK_DESTROY as soon as the cookies are released, so they
+ *   can be reused by the frontend right away, but retires the objects only
+ *   after they are no longer used for scanout, unmapping the grants of many
+ *   of them at once in the background. The frontend then must not assume
+ *   the grants of a destroyed dumb buffer are unmapped by the time it gets
+ *   the response and must release them in a way which tolerates this,
+ *   e.g. deferring the release until the grants are no longer in use.
+ *
+ *****************************************************************************
+ *                            Backend to frontend responses
+ *****************************************************************************
+ *
+ * All response packets have the same length (64 octets)
+ *
+ *
+ * Response - generic response to any request:
+ *          0                 1                  2                3        octet
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                 id                |    operation    |      status     |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ *
+ * id - uint16_t, private guest value, echoed from request
+ * operation - uint8_t, operation code, echoed from request
+ * status - int8_t, XENDRM_RSP_OKAY or XENDRM_RSP_ERROR
+ *
+ *
+ * Framebuffer creation response - response to XENDRM_OP_FB_CREATE:
+ *          0                 1                  2                3        octet
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                 id                |    operation    |      status     |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               fb_handle                               |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ *
+ * fb_handle - uint32_t, backend private value identifying the framebuffer
+ *   created, e.g. an index into the backend's framebuffer table combined
+ *   with a generation counter of that table slot. XENDRM_FB_HANDLE_INVALID
+ *   if feature-fb-handle is not set or the request failed.
+ *
+ * If the frontend supplies a valid fb_handle in a request the backend may
+ *   use it to find the framebuffer without a fb_cookie lookup. The backend
+ *   must still check that the framebuffer found has the same fb_cookie as
+ *   in the request and must fall back to the fb_cookie lookup if it does not
+ *   (e.g. because of a stale generation). A handle is only valid until the
+ *   framebuffer it was returned for is destroyed.
+ *
+ *
+ * Capture response - response to XENDRM_OP_CAPTURE:
+ *          0                 1                  2                3        octet
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                 id                |    operation    |      status     |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               num_rects                               |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ *
+ * num_rects - uint32_t, number of changed regions reported with
+ *   XENDRM_EVT_CAPTURE events for this request, 0 unless
+ *   XENDRM_CAPTURE_FLAG_INCREMENTAL was set
  *
  *****************************************************************************
  *                            Backend to frontend events
@@ -462,6 +1139,16 @@
  * +-----------------+-----------------+-----------------+-----------------+
  * |                          fb_cookie high 32-bit                        |
  * +-----------------+-----------------+-----------------+-----------------+
+ * |                                 flags                                 |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                          vblank_seq low 32-bit                        |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                          vblank_seq high 32-bit                       |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                          timestamp low 32-bit                         |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                          timestamp high 32-bit                        |
+ * +-----------------+-----------------+-----------------+-----------------+
  * |                               reserved                                |
  * +-----------------+-----------------+-----------------+-----------------+
  * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
@@ -474,7 +1161,100 @@
  * crtc_idx - uint32_t, echoed value received in XENDRM_OP_PG_FLIP request
  * fb_cookie - uint64_t, unique to guest domain value used by the backend
  *   to map remote framebuffer to local in requests
+ * flags - uint32_t, XENDRM_PG_FLIP_EVT_FLAG_XXX
+ * vblank_seq - uint64_t, sequence number of the vertical blank of the CRTC
+ *   the page flip was done at or, with XENDRM_PG_FLIP_EVT_FLAG_SUPERSEDED,
+ *   the vertical blank at which the framebuffer was dropped, i.e. the one
+ *   the superseding page flip was done at. 0 if feature-timed-flip is not set
+ * timestamp - uint64_t, Xen system time in nanoseconds of that vertical
+ *   blank, 0 if feature-timed-flip is not set
+ *
+ * One event is sent for every XENDRM_OP_PG_FLIP request, in order of
+ *   requests for the same CRTC. Without XENDRM_PG_FLIP_EVT_FLAG_SUPERSEDED
+ *   it means the framebuffer is now being displayed and the one displayed
+ *   before it is no longer used for scanout. With the flag it means the
+ *   framebuffer was dropped from the queue without being displayed and is
+ *   not used by the backend any more, see flip-mode.
+ *
+ *
+ * Capture event - event from back to front reporting regions copied by
+ *   XENDRM_OP_CAPTURE with XENDRM_CAPTURE_FLAG_INCREMENTAL:
+ *          0                 1                  2                3        octet
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                 id                |      type       |     reserved    |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                                 crtc_idx                              |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                         dumb_cookie low 32-bit                        |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                         dumb_cookie high 32-bit                       |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               num_rects                               |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |              rect[0].x            |              rect[0].y            |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |            rect[0].width          |            rect[0].height         |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/\/|
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |              rect[4].x            |              rect[4].y            |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |            rect[4].width          |            rect[4].height         |
+ * +-----------------+-----------------+-----------------+-----------------+
+ * |                               reserved                                |
+ * +-----------------+-----------------+-----------------+-----------------+
+ *
+ * id - uint16_t, event id, may be used by front
+ * type - uint8_t, XENDRM_EVT_CAPTURE
+ * crtc_idx - uint32_t, echoed value received in XENDRM_OP_CAPTURE request
+ * dumb_cookie - uint64_t, echoed value received in XENDRM_OP_CAPTURE request
+ * num_rects - uint32_t, number of valid rect entries, at most
+ *   XENDRM_CAPTURE_EVT_MAX_RECTS
+ * rect[i] - changed region, uint16_t x, y, width and height in pixels of
+ *   the connector's resolution
+ *
+ *****************************************************************************
+ *                            Protocol version 2
+ *****************************************************************************
  *
+ * The packets above are protocol version 1. Their operation specific part
+ *   starts at octet 4, so most of the 64-bit fields are only 4 octets
+ *   aligned and have to be accessed octet by octet on strict alignment
+ *   architectures. In protocol version 2 the requests and events carry the
+ *   same fields, but every field is naturally aligned: the common header
+ *   takes 8 octets and 64-bit fields come first. Responses have no 64-bit
+ *   fields and are the same in both versions. Octet offsets of the fields
+ *   of version 2 packets:
+ *
+ * Request header:
+ *   id 0, operation 2, req_flags 3, reserved 4
+ * Request dumb creation:
+ *   dumb_cookie 8, width 16, height 20, bpp 24, gref_directory_start 28,
+ *   flags 32
+ * Request dumb destruction:
+ *   dumb_cookie 8
+ * Request framebuffer creation:
+ *   dumb_cookie 8, fb_cookie 16, width 24, height 28, pixel_format 32
+ * Request framebuffer destruction:
+ *   fb_cookie 8, fb_handle 16
+ * Request configuration set/reset:
+ *   fb_cookie 8, x 16, y 20, width 24, height 28, bpp 32, fb_handle 36,
+ *   scaling_mode 40
+ * Request page flip:
+ *   fb_cookie 8, target_vblank 16, present_time 24, crtc_idx 32,
+ *   fb_handle 36, flags 40
+ * Request capture:
+ *   dumb_cookie 8, crtc_idx 16, flags 20, pixel_format 24
+ * Request bulk destruction:
+ *   num_fb_cookies 8, num_dumb_cookies 10, reserved 12, cookie[0..5] 16
+ * Event header:
+ *   id 0, type 2, reserved 3
+ * Page flip complete event:
+ *   fb_cookie 8, vblank_seq 16, timestamp 24, crtc_idx 32, flags 36
+ * Capture event:
+ *   dumb_cookie 8, crtc_idx 16, num_rects 20, rect[0..4] 24
+ *
+ * All fields not listed are reserved.
  */
 
 struct xendrm_request {
@@ -489,6 +1269,53 @@ struct xendrm_event {
 	uint8_t raw[64];
 };
 
+/*
+ * Statistics page, see stats-page-ref.
+ *
+ * The backend updates the counters with relaxed atomic 64-bit increments
+ * and never reads them back on its request path, so a monitoring tool in
+ * the frontend domain may read the page at any time without any locking.
+ * Counters are not updated together, so a snapshot is only consistent
+ * per counter; on 32-bit readers a counter must be re-read if it changed
+ * between loading its halves.
+ *
+ * version - uint32_t, XENDRM_STATS_VERSION once the backend has mapped
+ *   the page, 0 otherwise
+ * num_ops - uint32_t, number of op[] entries the backend maintains
+ * num_lat_buckets - uint32_t, number of latency[] entries the backend
+ *   maintains
+ * evt_count - uint64_t, number of events sent
+ * evt_ring_full - uint64_t, number of times the backend had to wait for
+ *   free space in the event ring
+ * op[XENDRM_OP_*] - per request code counters:
+ *   count - uint64_t, number of requests processed
+ *   errors - uint64_t, number of requests completed with a status other
+ *     than XENDRM_RSP_OKAY
+ *   latency[i] - uint64_t, number of requests for which the time from
+ *     reading the request to posting its response was below 2^(i+1)
+ *     microseconds and, for i > 0, at least 2^i microseconds. The last
+ *     bucket also counts all slower requests.
+ */
+#define XENDRM_STATS_VERSION             1
+#define XENDRM_STATS_NUM_OPS             16
+#define XENDRM_STATS_NUM_LAT_BUCKETS     24
+
+struct xendrm_stats_op {
+	uint64_t count;
+	uint64_t errors;
+	uint64_t latency[XENDRM_STATS_NUM_LAT_BUCKETS];
+};
+
+struct xendrm_stats_page {
+	uint32_t version;
+	uint32_t num_ops;
+	uint32_t num_lat_buckets;
+	uint32_t reserved;
+	uint64_t evt_count;
+	uint64_t evt_ring_full;
+	struct xendrm_stats_op op[XENDRM_STATS_NUM_OPS];
+};
+
 struct xendrm_event_page {
 	union {
 		struct xendrm_event raw;
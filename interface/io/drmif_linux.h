@@ -34,12 +34,19 @@
 #include <xen/interface/io/drmif.h>
 #include <xen/interface/grant_table.h>
 
+#ifdef __KERNEL__
+#include <linux/string.h>
+#else
+#include <string.h>
+#endif
+
 struct xendrm_dumb_create_req {
 	uint64_t dumb_cookie;
 	uint32_t width;
 	uint32_t height;
 	uint32_t bpp;
 	grant_ref_t gref_directory_start;
+	uint32_t flags;
 } __packed;
 
 struct xendrm_dumb_destroy_req {
@@ -56,6 +63,7 @@ struct xendrm_fb_create_req {
 
 struct xendrm_fb_destroy_req {
 	uint64_t fb_cookie;
+	uint32_t fb_handle;
 } __packed;
 
 struct xendrm_set_config_req {
@@ -65,11 +73,32 @@ struct xendrm_set_config_req {
 	uint32_t width;
 	uint32_t height;
 	uint32_t bpp;
+	uint32_t fb_handle;
+	uint32_t scaling_mode;
 } __packed;
 
 struct xendrm_page_flip_req {
 	uint32_t crtc_idx;
 	uint64_t fb_cookie;
+	uint32_t fb_handle;
+	uint32_t flags;
+	uint64_t target_vblank;
+	uint64_t present_time;
+} __packed;
+
+struct xendrm_capture_req {
+	uint32_t crtc_idx;
+	uint64_t dumb_cookie;
+	uint32_t flags;
+	uint32_t pixel_format;
+} __packed;
+
+#define XENDRM_BULK_DESTROY_MAX_COOKIES	6
+
+struct xendrm_bulk_destroy_req {
+	uint16_t num_fb_cookies;
+	uint16_t num_dumb_cookies;
+	uint64_t cookie[XENDRM_BULK_DESTROY_MAX_COOKIES];
 } __packed;
 
 struct xendrm_page_directory {
@@ -84,7 +113,7 @@ struct xendrm_req {
 		struct {
 			uint16_t id;
 			uint8_t operation;
-			uint8_t reserved;
+			uint8_t req_flags;
 			union {
 				struct xendrm_dumb_create_req dumb_create;
 				struct xendrm_dumb_destroy_req dumb_destroy;
@@ -92,11 +121,21 @@ struct xendrm_req {
 				struct xendrm_fb_destroy_req fb_destroy;
 				struct xendrm_set_config_req set_config;
 				struct xendrm_page_flip_req pg_flip;
+				struct xendrm_capture_req capture;
+				struct xendrm_bulk_destroy_req bulk_destroy;
 			} op;
 		} data;
 	} u;
 };
 
+struct xendrm_fb_create_resp {
+	uint32_t fb_handle;
+} __packed;
+
+struct xendrm_capture_resp {
+	uint32_t num_rects;
+} __packed;
+
 struct xendrm_resp {
 	union {
 		struct xendrm_response raw;
@@ -104,6 +143,10 @@ struct xendrm_resp {
 			uint16_t id;
 			uint8_t operation;
 			int8_t status;
+			union {
+				struct xendrm_fb_create_resp fb_create;
+				struct xendrm_capture_resp capture;
+			} op;
 		} data;
 	} u;
 };
@@ -111,6 +154,25 @@ struct xendrm_resp {
 struct xendrm_pg_flip_evt {
 	uint32_t crtc_idx;
 	uint64_t fb_cookie;
+	uint32_t flags;
+	uint64_t vblank_seq;
+	uint64_t timestamp;
+} __packed;
+
+struct xendrm_rect {
+	uint16_t x;
+	uint16_t y;
+	uint16_t width;
+	uint16_t height;
+} __packed;
+
+#define XENDRM_CAPTURE_EVT_MAX_RECTS	5
+
+struct xendrm_capture_evt {
+	uint32_t crtc_idx;
+	uint64_t dumb_cookie;
+	uint32_t num_rects;
+	struct xendrm_rect rect[XENDRM_CAPTURE_EVT_MAX_RECTS];
 } __packed;
 
 struct xendrm_evt {
@@ -122,12 +184,159 @@ struct xendrm_evt {
 			uint8_t reserved;
 			union {
 				struct xendrm_pg_flip_evt pg_flip;
+				struct xendrm_capture_evt capture;
+			} op;
+		} data;
+	} u;
+};
+
+/*
+ * protocol version 2 packets: the same fields as above, but naturally
+ * aligned, so no packing is needed
+ */
+
+struct xendrm_dumb_create_req_v2 {
+	uint64_t dumb_cookie;
+	uint32_t width;
+	uint32_t height;
+	uint32_t bpp;
+	grant_ref_t gref_directory_start;
+	uint32_t flags;
+	uint32_t reserved;
+};
+
+struct xendrm_dumb_destroy_req_v2 {
+	uint64_t dumb_cookie;
+};
+
+struct xendrm_fb_create_req_v2 {
+	uint64_t dumb_cookie;
+	uint64_t fb_cookie;
+	uint32_t width;
+	uint32_t height;
+	uint32_t pixel_format;
+	uint32_t reserved;
+};
+
+struct xendrm_fb_destroy_req_v2 {
+	uint64_t fb_cookie;
+	uint32_t fb_handle;
+	uint32_t reserved;
+};
+
+struct xendrm_set_config_req_v2 {
+	uint64_t fb_cookie;
+	uint32_t x;
+	uint32_t y;
+	uint32_t width;
+	uint32_t height;
+	uint32_t bpp;
+	uint32_t fb_handle;
+	uint32_t scaling_mode;
+	uint32_t reserved;
+};
+
+struct xendrm_page_flip_req_v2 {
+	uint64_t fb_cookie;
+	uint64_t target_vblank;
+	uint64_t present_time;
+	uint32_t crtc_idx;
+	uint32_t fb_handle;
+	uint32_t flags;
+	uint32_t reserved;
+};
+
+struct xendrm_capture_req_v2 {
+	uint64_t dumb_cookie;
+	uint32_t crtc_idx;
+	uint32_t flags;
+	uint32_t pixel_format;
+	uint32_t reserved;
+};
+
+struct xendrm_bulk_destroy_req_v2 {
+	uint16_t num_fb_cookies;
+	uint16_t num_dumb_cookies;
+	uint32_t reserved;
+	uint64_t cookie[XENDRM_BULK_DESTROY_MAX_COOKIES];
+};
+
+struct xendrm_req_v2 {
+	union {
+		struct xendrm_request raw;
+		struct {
+			uint16_t id;
+			uint8_t operation;
+			uint8_t req_flags;
+			uint32_t reserved;
+			union {
+				struct xendrm_dumb_create_req_v2 dumb_create;
+				struct xendrm_dumb_destroy_req_v2 dumb_destroy;
+				struct xendrm_fb_create_req_v2 fb_create;
+				struct xendrm_fb_destroy_req_v2 fb_destroy;
+				struct xendrm_set_config_req_v2 set_config;
+				struct xendrm_page_flip_req_v2 pg_flip;
+				struct xendrm_capture_req_v2 capture;
+				struct xendrm_bulk_destroy_req_v2 bulk_destroy;
+			} op;
+		} data;
+	} u;
+};
+
+struct xendrm_pg_flip_evt_v2 {
+	uint64_t fb_cookie;
+	uint64_t vblank_seq;
+	uint64_t timestamp;
+	uint32_t crtc_idx;
+	uint32_t flags;
+};
+
+struct xendrm_capture_evt_v2 {
+	uint64_t dumb_cookie;
+	uint32_t crtc_idx;
+	uint32_t num_rects;
+	struct xendrm_rect rect[XENDRM_CAPTURE_EVT_MAX_RECTS];
+};
+
+struct xendrm_evt_v2 {
+	union {
+		struct xendrm_event raw;
+		struct {
+			uint16_t id;
+			uint8_t type;
+			uint8_t reserved;
+			uint32_t reserved1;
+			union {
+				struct xendrm_pg_flip_evt_v2 pg_flip;
+				struct xendrm_capture_evt_v2 capture;
 			} op;
 		} data;
 	} u;
 };
 
 DEFINE_RING_TYPES(xen_drmif, struct xendrm_req, struct xendrm_resp);
+DEFINE_RING_TYPES(xen_drmif_v2, struct xendrm_req_v2, struct xendrm_resp);
+
+/* control ring poller state, see ctrl-poll */
+
+#define XENDRM_CTRL_POLL_STATE(sring) \
+	(((uint8_t *)&(sring)->rsp_event)[sizeof(RING_IDX)])
+
+/* dumb buffer geometry and its page directory */
+
+#define XENDRM_NUM_GREFS_PER_PAGE \
+	((PAGE_SIZE - sizeof(struct xendrm_page_directory)) / \
+	sizeof(grant_ref_t))
+#define XENDRM_DUMB_PITCH(width, bpp) \
+	(((uint64_t)(width) * (bpp) + 7) / 8)
+#define XENDRM_DUMB_SIZE(width, height, bpp) \
+	(XENDRM_DUMB_PITCH((width), (bpp)) * (height))
+#define XENDRM_DUMB_NUM_GREFS(width, height, bpp) \
+	((XENDRM_DUMB_SIZE((width), (height), (bpp)) + PAGE_SIZE - 1) / \
+	PAGE_SIZE)
+#define XENDRM_DUMB_NUM_DIR_PAGES(width, height, bpp) \
+	((XENDRM_DUMB_NUM_GREFS((width), (height), (bpp)) + \
+	XENDRM_NUM_GREFS_PER_PAGE - 1) / XENDRM_NUM_GREFS_PER_PAGE)
 
 /* shared page for back to front events */
 
@@ -138,5 +347,287 @@ DEFINE_RING_TYPES(xen_drmif, struct xendrm_req, struct xendrm_resp);
 	((struct xendrm_evt *)((char *)(page) + XENDRM_IN_RING_OFFS))
 #define XENDRM_IN_RING_REF(page, idx) \
 	(XENDRM_IN_RING((page))[(idx) % XENDRM_IN_RING_LEN])
+#define XENDRM_IN_RING_V2(page) \
+	((struct xendrm_evt_v2 *)((char *)(page) + XENDRM_IN_RING_OFFS))
+#define XENDRM_IN_RING_REF_V2(page, idx) \
+	(XENDRM_IN_RING_V2((page))[(idx) % XENDRM_IN_RING_LEN])
+
+/*
+ * conversion between protocol version 1 and 2 packets, so a driver can
+ * handle both versions with the same code working on version 2 packets;
+ * these return 0 on success or -1 if the operation or event type is unknown
+ * or the packet is invalid, e.g. lists more than
+ * XENDRM_BULK_DESTROY_MAX_COOKIES cookies
+ */
+
+static inline int xendrm_req_to_v2(struct xendrm_req_v2 *dst,
+	const struct xendrm_req *src)
+{
+	unsigned int i, n;
+
+	memset(dst, 0, sizeof(*dst));
+	dst->u.data.id = src->u.data.id;
+	dst->u.data.operation = src->u.data.operation;
+	dst->u.data.req_flags = src->u.data.req_flags;
+	switch (src->u.data.operation) {
+	case XENDRM_OP_DUMB_CREATE:
+		dst->u.data.op.dumb_create.dumb_cookie =
+			src->u.data.op.dumb_create.dumb_cookie;
+		dst->u.data.op.dumb_create.width =
+			src->u.data.op.dumb_create.width;
+		dst->u.data.op.dumb_create.height =
+			src->u.data.op.dumb_create.height;
+		dst->u.data.op.dumb_create.bpp =
+			src->u.data.op.dumb_create.bpp;
+		dst->u.data.op.dumb_create.gref_directory_start =
+			src->u.data.op.dumb_create.gref_directory_start;
+		dst->u.data.op.dumb_create.flags =
+			src->u.data.op.dumb_create.flags;
+		return 0;
+	case XENDRM_OP_DUMB_DESTROY:
+		dst->u.data.op.dumb_destroy.dumb_cookie =
+			src->u.data.op.dumb_destroy.dumb_cookie;
+		return 0;
+	case XENDRM_OP_FB_CREATE:
+		dst->u.data.op.fb_create.dumb_cookie =
+			src->u.data.op.fb_create.dumb_cookie;
+		dst->u.data.op.fb_create.fb_cookie =
+			src->u.data.op.fb_create.fb_cookie;
+		dst->u.data.op.fb_create.width =
+			src->u.data.op.fb_create.width;
+		dst->u.data.op.fb_create.height =
+			src->u.data.op.fb_create.height;
+		dst->u.data.op.fb_create.pixel_format =
+			src->u.data.op.fb_create.pixel_format;
+		return 0;
+	case XENDRM_OP_FB_DESTROY:
+		dst->u.data.op.fb_destroy.fb_cookie =
+			src->u.data.op.fb_destroy.fb_cookie;
+		dst->u.data.op.fb_destroy.fb_handle =
+			src->u.data.op.fb_destroy.fb_handle;
+		return 0;
+	case XENDRM_OP_SET_CONFIG:
+		dst->u.data.op.set_config.fb_cookie =
+			src->u.data.op.set_config.fb_cookie;
+		dst->u.data.op.set_config.x = src->u.data.op.set_config.x;
+		dst->u.data.op.set_config.y = src->u.data.op.set_config.y;
+		dst->u.data.op.set_config.width =
+			src->u.data.op.set_config.width;
+		dst->u.data.op.set_config.height =
+			src->u.data.op.set_config.height;
+		dst->u.data.op.set_config.bpp = src->u.data.op.set_config.bpp;
+		dst->u.data.op.set_config.fb_handle =
+			src->u.data.op.set_config.fb_handle;
+		dst->u.data.op.set_config.scaling_mode =
+			src->u.data.op.set_config.scaling_mode;
+		return 0;
+	case XENDRM_OP_PG_FLIP:
+		dst->u.data.op.pg_flip.fb_cookie =
+			src->u.data.op.pg_flip.fb_cookie;
+		dst->u.data.op.pg_flip.target_vblank =
+			src->u.data.op.pg_flip.target_vblank;
+		dst->u.data.op.pg_flip.present_time =
+			src->u.data.op.pg_flip.present_time;
+		dst->u.data.op.pg_flip.crtc_idx =
+			src->u.data.op.pg_flip.crtc_idx;
+		dst->u.data.op.pg_flip.fb_handle =
+			src->u.data.op.pg_flip.fb_handle;
+		dst->u.data.op.pg_flip.flags = src->u.data.op.pg_flip.flags;
+		return 0;
+	case XENDRM_OP_CAPTURE:
+		dst->u.data.op.capture.dumb_cookie =
+			src->u.data.op.capture.dumb_cookie;
+		dst->u.data.op.capture.crtc_idx =
+			src->u.data.op.capture.crtc_idx;
+		dst->u.data.op.capture.flags = src->u.data.op.capture.flags;
+		dst->u.data.op.capture.pixel_format =
+			src->u.data.op.capture.pixel_format;
+		return 0;
+	case XENDRM_OP_BULK_DESTROY:
+		n = src->u.data.op.bulk_destroy.num_fb_cookies +
+			src->u.data.op.bulk_destroy.num_dumb_cookies;
+		if (n > XENDRM_BULK_DESTROY_MAX_COOKIES)
+			return -1;
+		dst->u.data.op.bulk_destroy.num_fb_cookies =
+			src->u.data.op.bulk_destroy.num_fb_cookies;
+		dst->u.data.op.bulk_destroy.num_dumb_cookies =
+			src->u.data.op.bulk_destroy.num_dumb_cookies;
+		for (i = 0; i < n; i++)
+			dst->u.data.op.bulk_destroy.cookie[i] =
+				src->u.data.op.bulk_destroy.cookie[i];
+		return 0;
+	}
+	return -1;
+}
+
+static inline int xendrm_req_from_v2(struct xendrm_req *dst,
+	const struct xendrm_req_v2 *src)
+{
+	unsigned int i, n;
+
+	memset(dst, 0, sizeof(*dst));
+	dst->u.data.id = src->u.data.id;
+	dst->u.data.operation = src->u.data.operation;
+	dst->u.data.req_flags = src->u.data.req_flags;
+	switch (src->u.data.operation) {
+	case XENDRM_OP_DUMB_CREATE:
+		dst->u.data.op.dumb_create.dumb_cookie =
+			src->u.data.op.dumb_create.dumb_cookie;
+		dst->u.data.op.dumb_create.width =
+			src->u.data.op.dumb_create.width;
+		dst->u.data.op.dumb_create.height =
+			src->u.data.op.dumb_create.height;
+		dst->u.data.op.dumb_create.bpp =
+			src->u.data.op.dumb_create.bpp;
+		dst->u.data.op.dumb_create.gref_directory_start =
+			src->u.data.op.dumb_create.gref_directory_start;
+		dst->u.data.op.dumb_create.flags =
+			src->u.data.op.dumb_create.flags;
+		return 0;
+	case XENDRM_OP_DUMB_DESTROY:
+		dst->u.data.op.dumb_destroy.dumb_cookie =
+			src->u.data.op.dumb_destroy.dumb_cookie;
+		return 0;
+	case XENDRM_OP_FB_CREATE:
+		dst->u.data.op.fb_create.dumb_cookie =
+			src->u.data.op.fb_create.dumb_cookie;
+		dst->u.data.op.fb_create.fb_cookie =
+			src->u.data.op.fb_create.fb_cookie;
+		dst->u.data.op.fb_create.width =
+			src->u.data.op.fb_create.width;
+		dst->u.data.op.fb_create.height =
+			src->u.data.op.fb_create.height;
+		dst->u.data.op.fb_create.pixel_format =
+			src->u.data.op.fb_create.pixel_format;
+		return 0;
+	case XENDRM_OP_FB_DESTROY:
+		dst->u.data.op.fb_destroy.fb_cookie =
+			src->u.data.op.fb_destroy.fb_cookie;
+		dst->u.data.op.fb_destroy.fb_handle =
+			src->u.data.op.fb_destroy.fb_handle;
+		return 0;
+	case XENDRM_OP_SET_CONFIG:
+		dst->u.data.op.set_config.fb_cookie =
+			src->u.data.op.set_config.fb_cookie;
+		dst->u.data.op.set_config.x = src->u.data.op.set_config.x;
+		dst->u.data.op.set_config.y = src->u.data.op.set_config.y;
+		dst->u.data.op.set_config.width =
+			src->u.data.op.set_config.width;
+		dst->u.data.op.set_config.height =
+			src->u.data.op.set_config.height;
+		dst->u.data.op.set_config.bpp = src->u.data.op.set_config.bpp;
+		dst->u.data.op.set_config.fb_handle =
+			src->u.data.op.set_config.fb_handle;
+		dst->u.data.op.set_config.scaling_mode =
+			src->u.data.op.set_config.scaling_mode;
+		return 0;
+	case XENDRM_OP_PG_FLIP:
+		dst->u.data.op.pg_flip.fb_cookie =
+			src->u.data.op.pg_flip.fb_cookie;
+		dst->u.data.op.pg_flip.target_vblank =
+			src->u.data.op.pg_flip.target_vblank;
+		dst->u.data.op.pg_flip.present_time =
+			src->u.data.op.pg_flip.present_time;
+		dst->u.data.op.pg_flip.crtc_idx =
+			src->u.data.op.pg_flip.crtc_idx;
+		dst->u.data.op.pg_flip.fb_handle =
+			src->u.data.op.pg_flip.fb_handle;
+		dst->u.data.op.pg_flip.flags = src->u.data.op.pg_flip.flags;
+		return 0;
+	case XENDRM_OP_CAPTURE:
+		dst->u.data.op.capture.dumb_cookie =
+			src->u.data.op.capture.dumb_cookie;
+		dst->u.data.op.capture.crtc_idx =
+			src->u.data.op.capture.crtc_idx;
+		dst->u.data.op.capture.flags = src->u.data.op.capture.flags;
+		dst->u.data.op.capture.pixel_format =
+			src->u.data.op.capture.pixel_format;
+		return 0;
+	case XENDRM_OP_BULK_DESTROY:
+		n = src->u.data.op.bulk_destroy.num_fb_cookies +
+			src->u.data.op.bulk_destroy.num_dumb_cookies;
+		if (n > XENDRM_BULK_DESTROY_MAX_COOKIES)
+			return -1;
+		dst->u.data.op.bulk_destroy.num_fb_cookies =
+			src->u.data.op.bulk_destroy.num_fb_cookies;
+		dst->u.data.op.bulk_destroy.num_dumb_cookies =
+			src->u.data.op.bulk_destroy.num_dumb_cookies;
+		for (i = 0; i < n; i++)
+			dst->u.data.op.bulk_destroy.cookie[i] =
+				src->u.data.op.bulk_destroy.cookie[i];
+		return 0;
+	}
+	return -1;
+}
+
+static inline int xendrm_evt_to_v2(struct xendrm_evt_v2 *dst,
+	const struct xendrm_evt *src)
+{
+	unsigned int i;
+
+	memset(dst, 0, sizeof(*dst));
+	dst->u.data.id = src->u.data.id;
+	dst->u.data.type = src->u.data.type;
+	switch (src->u.data.type) {
+	case XENDRM_EVT_PG_FLIP:
+		dst->u.data.op.pg_flip.fb_cookie =
+			src->u.data.op.pg_flip.fb_cookie;
+		dst->u.data.op.pg_flip.vblank_seq =
+			src->u.data.op.pg_flip.vblank_seq;
+		dst->u.data.op.pg_flip.timestamp =
+			src->u.data.op.pg_flip.timestamp;
+		dst->u.data.op.pg_flip.crtc_idx =
+			src->u.data.op.pg_flip.crtc_idx;
+		dst->u.data.op.pg_flip.flags = src->u.data.op.pg_flip.flags;
+		return 0;
+	case XENDRM_EVT_CAPTURE:
+		dst->u.data.op.capture.dumb_cookie =
+			src->u.data.op.capture.dumb_cookie;
+		dst->u.data.op.capture.crtc_idx =
+			src->u.data.op.capture.crtc_idx;
+		dst->u.data.op.capture.num_rects =
+			src->u.data.op.capture.num_rects;
+		for (i = 0; i < XENDRM_CAPTURE_EVT_MAX_RECTS; i++)
+			dst->u.data.op.capture.rect[i] =
+				src->u.data.op.capture.rect[i];
+		return 0;
+	}
+	return -1;
+}
+
+static inline int xendrm_evt_from_v2(struct xendrm_evt *dst,
+	const struct xendrm_evt_v2 *src)
+{
+	unsigned int i;
+
+	memset(dst, 0, sizeof(*dst));
+	dst->u.data.id = src->u.data.id;
+	dst->u.data.type = src->u.data.type;
+	switch (src->u.data.type) {
+	case XENDRM_EVT_PG_FLIP:
+		dst->u.data.op.pg_flip.fb_cookie =
+			src->u.data.op.pg_flip.fb_cookie;
+		dst->u.data.op.pg_flip.vblank_seq =
+			src->u.data.op.pg_flip.vblank_seq;
+		dst->u.data.op.pg_flip.timestamp =
+			src->u.data.op.pg_flip.timestamp;
+		dst->u.data.op.pg_flip.crtc_idx =
+			src->u.data.op.pg_flip.crtc_idx;
+		dst->u.data.op.pg_flip.flags = src->u.data.op.pg_flip.flags;
+		return 0;
+	case XENDRM_EVT_CAPTURE:
+		dst->u.data.op.capture.dumb_cookie =
+			src->u.data.op.capture.dumb_cookie;
+		dst->u.data.op.capture.crtc_idx =
+			src->u.data.op.capture.crtc_idx;
+		dst->u.data.op.capture.num_rects =
+			src->u.data.op.capture.num_rects;
+		for (i = 0; i < XENDRM_CAPTURE_EVT_MAX_RECTS; i++)
+			dst->u.data.op.capture.rect[i] =
+				src->u.data.op.capture.rect[i];
+		return 0;
+	}
+	return -1;
+}
 
 #endif /* __XEN_PUBLIC_IO_XENDRM_LINUX_H__ */